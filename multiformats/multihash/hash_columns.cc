@@ -0,0 +1,88 @@
+#include "hash_columns.h"
+
+#include <array>
+
+namespace multi::hash {
+
+namespace internal {
+
+// codes below this are looked up in a flat table instead of default_lengths
+constexpr size_t SMALL_CODES = 0x80;
+
+static array<uint8_t, SMALL_CODES> small_code_lengths() {
+  array<uint8_t, SMALL_CODES> lengths{};
+  for (auto& [func, name] : code_names) {
+    auto code = static_cast<underlying_type_t<HFuncCode>>(func);
+    if (code < SMALL_CODES) lengths[code] = default_lengths[func];
+  }
+  return lengths;
+}
+
+/*
+Return the digest length of a registered hash function, or 0 if the
+code is unknown. BLAKE2 lengths follow from their position in the
+code range, the rest come from the registry.
+*/
+static size_t registered_length(uint64_t code) {
+  static const auto small = small_code_lengths();
+  if (code < SMALL_CODES) return small[code];
+  if (is_blake2b(HFuncCode{code})) {
+    return code -
+           static_cast<underlying_type_t<HFuncCode>>(HFuncCode::BLAKE2B_MIN) +
+           1;
+  }
+  if (is_blake2s(HFuncCode{code})) {
+    return code -
+           static_cast<underlying_type_t<HFuncCode>>(HFuncCode::BLAKE2S_MIN) +
+           1;
+  }
+  return 0;
+}
+
+}  // namespace internal
+
+optional<HashColumns> DecodeAll(const vector<uint8_t>& raw_sums, Arena& arena) {
+  auto end = raw_sums.cend();
+
+  // first pass validates every entry and sizes the columns
+  size_t count        = 0;
+  size_t digest_bytes = 0;
+  for (auto it = raw_sums.cbegin(); it != end;) {
+    auto [code, c_len] = varint::decode(it, end);
+    if (c_len == 0 || c_len > 10) return {};
+    it += c_len;
+    auto [len, l_len] = varint::decode(it, end);
+    if (l_len == 0 || l_len > 10) return {};
+    it += l_len;
+    if (len == 0 || len != internal::registered_length(code)) return {};
+    if (size_t(end - it) < len) return {};
+    it += len;
+    count++;
+    digest_bytes += len;
+  }
+
+  // second pass copies the already validated entries into the columns
+  HashColumns out;
+  out._size    = count;
+  out._codes   = arena.allocate<HFuncCode>(count);
+  out._offsets = arena.allocate<uint64_t>(count + 1);
+  out._digests = arena.allocate<uint8_t>(digest_bytes);
+
+  uint64_t offset = 0;
+  auto     it     = raw_sums.cbegin();
+  for (size_t i = 0; i < count; i++) {
+    auto [code, c_len] = varint::decode(it, end);
+    it += c_len;
+    auto [len, l_len] = varint::decode(it, end);
+    it += l_len;
+    out._codes[i]   = HFuncCode{code};
+    out._offsets[i] = offset;
+    copy(it, it + len, out._digests + offset);
+    it += len;
+    offset += len;
+  }
+  out._offsets[count] = offset;
+  return out;
+}
+
+}  // namespace multi::hash
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "multiformats/multihash/multihash.h"
+#include "multiformats/util/arena.h"
+#include "multiformats/util/common.h"
+
+namespace multi::hash {
+
+using namespace std;
+
+/*
+A sequence of decoded multihashes stored column-wise: one array of
+hash function codes, one array of digest offsets and one array with
+all the digests packed back to back. The columns live in the Arena
+passed to DecodeAll(), which must outlive the HashColumns object.
+
+Digest i occupies digests()[offsets()[i]] up to, but not including,
+digests()[offsets()[i + 1]].
+*/
+class HashColumns {
+ public:
+  size_t size() const {
+    return _size;
+  }
+  bool empty() const {
+    return _size == 0;
+  }
+
+  HFuncCode code(size_t i) const {
+    return _codes[i];
+  }
+  const uint8_t* digest(size_t i) const {
+    return _digests + _offsets[i];
+  }
+  size_t digest_len(size_t i) const {
+    return _offsets[i + 1] - _offsets[i];
+  }
+
+  // size() codes
+  const HFuncCode* codes() const {
+    return _codes;
+  }
+  // size() + 1 offsets into digests()
+  const uint64_t* offsets() const {
+    return _offsets;
+  }
+  const uint8_t* digests() const {
+    return _digests;
+  }
+
+  friend optional<HashColumns> DecodeAll(const vector<uint8_t>& raw_sums,
+                                         Arena&                 arena);
+
+ private:
+  HashColumns() = default;
+
+  size_t     _size    = 0;
+  HFuncCode* _codes   = nullptr;
+  uint64_t*  _offsets = nullptr;
+  uint8_t*   _digests = nullptr;
+};
+
+/*
+Decode a buffer holding any number of raw multihash sums laid end to
+end into columns allocated from arena. Every entry is validated the
+same way Decode() does; if any of them is malformed, truncated or
+uses an unknown hash function, an empty std::optional is returned.
+*/
+optional<HashColumns> DecodeAll(const vector<uint8_t>& raw_sums, Arena& arena);
+
+}  // namespace multi::hash
@@ -0,0 +1,345 @@
+#include "hash_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#include "multiformats/util/worker_pool.h"
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define MULTI_IO_URING
+#endif
+
+namespace multi::hash {
+
+namespace internal {
+
+// size of a single read, and of each registered buffer
+constexpr size_t CHUNK_SIZE = 1 << 17;
+// number of reads kept in flight per file
+constexpr unsigned QUEUE_DEPTH = 4;
+
+optional<Hash> hash_pread(int fd, Hasher& hasher) {
+  vector<uint8_t> buf(CHUNK_SIZE);
+  off_t           off = 0;
+  for (;;) {
+    auto n = pread(fd, buf.data(), buf.size(), off);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return {};
+    }
+    if (n == 0) break;
+    hasher.write(buf.data(), n);
+    off += n;
+  }
+  return hasher.finalize();
+}
+
+#ifdef MULTI_IO_URING
+
+/*
+Minimal io_uring wrapper talking to the kernel through the raw
+syscalls. It owns QUEUE_DEPTH buffers of CHUNK_SIZE bytes, registered
+with the kernel when possible so reads can use IORING_OP_READ_FIXED.
+It is driven by a single thread.
+*/
+class Ring {
+ public:
+  static unique_ptr<Ring> New();
+  ~Ring();
+
+  uint8_t* buffer(unsigned slot) {
+    return _buffers + slot * CHUNK_SIZE;
+  }
+  // queue a read of len bytes at off into buffer(slot) + skip
+  void queue_read(int fd, unsigned slot, size_t skip, size_t len,
+                  uint64_t off);
+  // submit queued reads and pop one completion, blocking if needed
+  bool wait(io_uring_cqe& cqe);
+  // set once wait() fails, with reads possibly still in flight
+  bool broken() const {
+    return _broken;
+  }
+
+ private:
+  Ring() = default;
+  bool setup();
+  bool pop(io_uring_cqe& cqe);
+
+  int           _fd         = -1;
+  void*         _sq_ptr     = MAP_FAILED;
+  size_t        _sq_size    = 0;
+  void*         _cq_ptr     = MAP_FAILED;
+  size_t        _cq_size    = 0;
+  io_uring_sqe* _sqes       = (io_uring_sqe*)MAP_FAILED;
+  size_t        _sqes_size  = 0;
+  uint8_t*      _buffers    = (uint8_t*)MAP_FAILED;
+  bool          _fixed      = false;
+  bool          _broken     = false;
+  unsigned      _to_submit  = 0;
+  unsigned      _sq_entries = 0;
+
+  unsigned* _sq_tail;
+  unsigned* _sq_mask;
+  unsigned* _sq_array;
+  unsigned* _cq_head;
+  unsigned* _cq_tail;
+  unsigned* _cq_mask;
+
+  io_uring_cqe* _cqes;
+};
+
+unique_ptr<Ring> Ring::New() {
+  unique_ptr<Ring> ring(new Ring());
+  if (!ring->setup()) return nullptr;
+  return ring;
+}
+
+bool Ring::setup() {
+  io_uring_params p;
+  memset(&p, 0, sizeof(p));
+  _fd = syscall(__NR_io_uring_setup, QUEUE_DEPTH, &p);
+  if (_fd < 0) return false;
+
+  _sq_entries = p.sq_entries;
+  _sq_size    = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  _cq_size    = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    _sq_size = _cq_size = max(_sq_size, _cq_size);
+  }
+  _sq_ptr = mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+  if (_sq_ptr == MAP_FAILED) return false;
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    _cq_ptr = _sq_ptr;
+  } else {
+    _cq_ptr = mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+    if (_cq_ptr == MAP_FAILED) return false;
+  }
+  _sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+  _sqes      = (io_uring_sqe*)mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+  if (_sqes == MAP_FAILED) return false;
+
+  auto sq   = (uint8_t*)_sq_ptr;
+  auto cq   = (uint8_t*)_cq_ptr;
+  _sq_tail  = (unsigned*)(sq + p.sq_off.tail);
+  _sq_mask  = (unsigned*)(sq + p.sq_off.ring_mask);
+  _sq_array = (unsigned*)(sq + p.sq_off.array);
+  _cq_head  = (unsigned*)(cq + p.cq_off.head);
+  _cq_tail  = (unsigned*)(cq + p.cq_off.tail);
+  _cq_mask  = (unsigned*)(cq + p.cq_off.ring_mask);
+  _cqes     = (io_uring_cqe*)(cq + p.cq_off.cqes);
+
+  _buffers = (uint8_t*)mmap(nullptr, QUEUE_DEPTH * CHUNK_SIZE,
+                            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1, 0);
+  if (_buffers == MAP_FAILED) return false;
+
+  // registration can fail under a low RLIMIT_MEMLOCK, plain reads still work
+  array<iovec, QUEUE_DEPTH> iovs;
+  for (unsigned i = 0; i < QUEUE_DEPTH; i++) {
+    iovs[i] = {buffer(i), CHUNK_SIZE};
+  }
+  _fixed = syscall(__NR_io_uring_register, _fd, IORING_REGISTER_BUFFERS,
+                   iovs.data(), QUEUE_DEPTH) == 0;
+  return true;
+}
+
+Ring::~Ring() {
+  if (_fd >= 0) close(_fd);
+  if (_sqes != MAP_FAILED) munmap(_sqes, _sqes_size);
+  if (_cq_ptr != MAP_FAILED && _cq_ptr != _sq_ptr) munmap(_cq_ptr, _cq_size);
+  if (_sq_ptr != MAP_FAILED) munmap(_sq_ptr, _sq_size);
+  /*
+  Closing the ring doesn't wait for reads still in flight. Registered
+  buffers stay pinned by the kernel until those finish, but plain
+  reads target the addresses, which a later mmap() could hand out
+  again, so a broken ring leaks its buffers instead of unmapping them.
+  */
+  if (_buffers != MAP_FAILED && (_fixed || !_broken)) {
+    munmap(_buffers, QUEUE_DEPTH * CHUNK_SIZE);
+  }
+}
+
+void Ring::queue_read(int fd, unsigned slot, size_t skip, size_t len,
+                      uint64_t off) {
+  // only this thread produces entries, so the tail can be read plainly
+  auto tail = *_sq_tail;
+  auto idx  = tail & *_sq_mask;
+  auto sqe  = &_sqes[idx];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode    = _fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+  sqe->fd        = fd;
+  sqe->addr      = (uint64_t)(buffer(slot) + skip);
+  sqe->len       = len;
+  sqe->off       = off;
+  sqe->buf_index = slot;
+  sqe->user_data = slot;
+  _sq_array[idx] = idx;
+  __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+  _to_submit++;
+}
+
+bool Ring::pop(io_uring_cqe& cqe) {
+  auto head = *_cq_head;
+  if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) return false;
+  cqe = _cqes[head & *_cq_mask];
+  __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool Ring::wait(io_uring_cqe& cqe) {
+  while (!pop(cqe)) {
+    auto ret = syscall(__NR_io_uring_enter, _fd, _to_submit, 1,
+                       IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      _broken = true;
+      return false;
+    }
+    _to_submit -= ret;
+  }
+  return true;
+}
+
+/*
+Each thread hashing files gets its own ring, created on first use.
+A broken ring may still complete reads from an earlier file, so it
+is replaced rather than reused.
+*/
+Ring* thread_ring() {
+  thread_local unique_ptr<Ring> ring;
+  thread_local bool             tried = false;
+  if (!tried || (ring && ring->broken())) {
+    tried = true;
+    ring.reset();
+    ring = Ring::New();
+  }
+  return ring.get();
+}
+
+/*
+Hash size bytes of fd keeping up to QUEUE_DEPTH reads in flight.
+Completions may arrive out of order, so finished chunks wait in their
+buffer until every chunk before them has been fed to the hasher, and
+the freed buffer is immediately reused for the next read.
+*/
+optional<Hash> hash_uring(Ring& ring, int fd, size_t size, Hasher& hasher) {
+  struct Slot {
+    uint64_t off;
+    size_t   len;
+    size_t   done;
+    bool     ready;
+  };
+  array<Slot, QUEUE_DEPTH> slots;
+
+  uint64_t next_read = 0;
+  uint64_t next_feed = 0;
+  unsigned inflight  = 0;
+  bool     failed    = false;
+
+  auto start = [&](unsigned i) {
+    slots[i] = {next_read, min(CHUNK_SIZE, size - next_read), 0, false};
+    next_read += slots[i].len;
+    ring.queue_read(fd, i, 0, slots[i].len, slots[i].off);
+    inflight++;
+  };
+
+  for (unsigned i = 0; i < QUEUE_DEPTH && next_read < size; i++) start(i);
+
+  while (inflight > 0) {
+    io_uring_cqe cqe;
+    // the ring is now marked broken and replaced by thread_ring()
+    if (!ring.wait(cqe)) return {};
+    inflight--;
+
+    auto  i = (unsigned)cqe.user_data;
+    auto& s = slots[i];
+    if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+      ring.queue_read(fd, i, s.done, s.len - s.done, s.off + s.done);
+      inflight++;
+      continue;
+    }
+    if (cqe.res <= 0) {
+      // drain whatever is still in flight before giving up
+      failed = true;
+      continue;
+    }
+    s.done += cqe.res;
+    if (s.done < s.len) {
+      // short read, ask for the rest of the chunk
+      ring.queue_read(fd, i, s.done, s.len - s.done, s.off + s.done);
+      inflight++;
+      continue;
+    }
+    s.ready = true;
+
+    for (bool fed = true; fed && !failed;) {
+      fed = false;
+      for (unsigned j = 0; j < QUEUE_DEPTH; j++) {
+        if (slots[j].ready && slots[j].off == next_feed) {
+          hasher.write(ring.buffer(j), slots[j].len);
+          next_feed += slots[j].len;
+          slots[j].ready = false;
+          if (next_read < size) start(j);
+          fed = true;
+        }
+      }
+    }
+  }
+  if (failed || next_feed != size) return {};
+  return hasher.finalize();
+}
+
+#endif  // MULTI_IO_URING
+
+}  // namespace internal
+
+bool io_uring_available() {
+#ifdef MULTI_IO_URING
+  static const bool available = internal::Ring::New() != nullptr;
+  return available;
+#else
+  return false;
+#endif
+}
+
+optional<Hash> hash_file(const string& path, HFuncCode func, FileIO io) {
+  auto hasher = Hasher::New(func);
+  if (!hasher) return {};
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return {};
+
+  optional<Hash> out;
+#ifdef MULTI_IO_URING
+  struct stat st;
+  if (io != FileIO::PREAD && fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    if (auto ring = internal::thread_ring()) {
+      // keep a fresh hasher around in case we need to retry with pread
+      auto h = *hasher;
+      out    = internal::hash_uring(*ring, fd, st.st_size, h);
+    }
+  }
+#endif
+  if (!out && io != FileIO::IO_URING) out = internal::hash_pread(fd, *hasher);
+  close(fd);
+  return out;
+}
+
+void hash_file_async(const string& path, HFuncCode func, HashCallback callback,
+                     FileIO io) {
+  WorkerPool::shared().push([=] { callback(hash_file(path, func, io)); });
+}
+
+}  // namespace multi::hash
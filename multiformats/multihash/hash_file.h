@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "multiformats/multihash/multihash.h"
+#include "multiformats/util/common.h"
+
+namespace multi::hash {
+
+using namespace std;
+
+/*
+I/O backend used to read files for hashing.
+
+  AUTO:     io_uring when the kernel supports it, pread otherwise
+  IO_URING: io_uring only, hashing fails if it can't be used (e.g.
+            unsupported kernel or not a regular file)
+  PREAD:    blocking pread() calls
+*/
+enum class FileIO { AUTO, IO_URING, PREAD };
+
+/*
+Called with the multihash of a file once hash_file_async() is done,
+or with an empty std::optional if the file couldn't be read.
+*/
+using HashCallback = function<void(optional<Hash>)>;
+
+/*
+Return true if io_uring can be used on this system.
+*/
+bool io_uring_available();
+
+/*
+Hash the contents of the file at path with the given hash function.
+Returns an empty std::optional if the file can't be opened or read,
+or the hash function is not supported by Hasher. The file must not be
+modified while it is being hashed.
+
+With io_uring several reads into registered buffers are kept in
+flight, and each completed chunk is fed to the hasher in file order
+while the next reads are serviced.
+
+SHA3 has no streaming implementation: the whole file is held in
+memory until it is digested, so prefer SHA2 or BLAKE2 for large files.
+*/
+optional<Hash> hash_file(const string& path, HFuncCode func,
+                         FileIO io = FileIO::AUTO);
+
+/*
+Queue the file at path to be hashed on a shared pool of worker
+threads, and return immediately. The callback is invoked on one of
+the worker threads when the hash is done, so it must be thread safe.
+*/
+void hash_file_async(const string& path, HFuncCode func, HashCallback callback,
+                     FileIO io = FileIO::AUTO);
+
+}  // namespace multi::hash
@@ -0,0 +1,179 @@
+#include "merkle.h"
+
+#include <cstring>
+
+#include "multiformats/util/worker_pool.h"
+
+namespace multi::hash {
+
+namespace internal {
+
+// smallest range of nodes handed to a single thread
+constexpr size_t PARALLEL_NODES = 1 << 12;
+
+constexpr uint8_t LEAF_PREFIX = 0x00;
+constexpr uint8_t NODE_PREFIX = 0x01;
+
+void hash_leaf(Hasher& hasher, const Hash& leaf, uint8_t* out) {
+  auto& raw = leaf.raw_sum_ref();
+  hasher.reset()
+      .write(&LEAF_PREFIX, 1)
+      .write(raw.data(), raw.size())
+      .finalize(out);
+}
+
+void hash_node(Hasher& hasher, const uint8_t* left, const uint8_t* right,
+               uint8_t* out) {
+  auto len = hasher.digest_len();
+  hasher.reset()
+      .write(&NODE_PREFIX, 1)
+      .write(left, len)
+      .write(right, len)
+      .finalize(out);
+}
+
+// wrap a bare digest back into a multihash
+Hash to_hash(HFuncCode func, const uint8_t* digest, size_t len) {
+  auto code = static_cast<underlying_type_t<HFuncCode>>(func);
+  auto raw  = varint::encode(code);
+  auto size = varint::encode(len);
+  raw.insert(raw.end(), size.begin(), size.end());
+  raw.insert(raw.end(), digest, digest + len);
+  return *Decode(raw);
+}
+
+}  // namespace internal
+
+bool MerkleProof::verify(const Hash& leaf, const Hash& root) const {
+  auto hasher = Hasher::New(func);
+  if (!hasher || index >= leaves) return false;
+  auto len = hasher->digest_len();
+  if (siblings.size() % len != 0) return false;
+
+  vector<uint8_t> digest(len);
+  internal::hash_leaf(*hasher, leaf, digest.data());
+
+  size_t used = 0;
+  for (size_t i = index, n = leaves; n > 1; i /= 2, n = (n + 1) / 2) {
+    // the last node of an odd level has no sibling
+    if ((i ^ 1) >= n) continue;
+    if (used == siblings.size()) return false;
+    auto sibling = &siblings[used];
+    if (i % 2 == 0) {
+      internal::hash_node(*hasher, digest.data(), sibling, digest.data());
+    } else {
+      internal::hash_node(*hasher, sibling, digest.data(), digest.data());
+    }
+    used += len;
+  }
+  if (used != siblings.size()) return false;
+  return internal::to_hash(func, digest.data(), len) == root;
+}
+
+optional<MerkleTree> MerkleTree::New(HFuncCode func) {
+  if (auto hasher = Hasher::New(func); hasher) {
+    return MerkleTree(*hasher);
+  }
+  return {};
+}
+
+optional<MerkleTree> MerkleTree::New(HFuncCode func,
+                                     const vector<Hash>& leaves) {
+  auto tree = New(func);
+  if (tree) tree->append(leaves);
+  return tree;
+}
+
+MerkleTree::MerkleTree(const Hasher& hasher) :
+    _hasher(hasher),
+    _digest_len(hasher.digest_len()),
+    _levels(1) {}
+
+size_t MerkleTree::size() const {
+  return level_size(0);
+}
+
+size_t MerkleTree::level_size(size_t level) const {
+  return _levels[level].size() / _digest_len;
+}
+
+uint8_t* MerkleTree::node(size_t level, size_t i) {
+  return &_levels[level][i * _digest_len];
+}
+
+optional<Hash> MerkleTree::root() const {
+  if (size() == 0) return {};
+  return internal::to_hash(_hasher.hash_func(), _levels.back().data(),
+                           _digest_len);
+}
+
+void MerkleTree::append(const Hash& leaf) {
+  auto i = size();
+  _levels[0].resize((i + 1) * _digest_len);
+  auto hasher = _hasher;
+  internal::hash_leaf(hasher, leaf, node(0, i));
+  rehash(i, i);
+}
+
+void MerkleTree::append(const vector<Hash>& leaves) {
+  if (leaves.empty()) return;
+  auto first = size();
+  _levels[0].resize((first + leaves.size()) * _digest_len);
+  WorkerPool::shared().parallel_for(
+      first, first + leaves.size(), internal::PARALLEL_NODES,
+      [&](size_t begin, size_t end) {
+        // one Hasher per range, reset between leaves
+        auto hasher = _hasher;
+        for (auto i = begin; i < end; i++) {
+          internal::hash_leaf(hasher, leaves[i - first], node(0, i));
+        }
+      });
+  rehash(first, size() - 1);
+}
+
+bool MerkleTree::update(size_t index, const Hash& leaf) {
+  if (index >= size()) return false;
+  auto hasher = _hasher;
+  internal::hash_leaf(hasher, leaf, node(0, index));
+  rehash(index, index);
+  return true;
+}
+
+void MerkleTree::rehash(size_t first, size_t last) {
+  for (size_t level = 0; level_size(level) > 1; level++) {
+    auto n       = level_size(level);
+    auto parents = (n + 1) / 2;
+    if (_levels.size() == level + 1) _levels.emplace_back();
+    _levels[level + 1].resize(parents * _digest_len);
+
+    first /= 2;
+    last /= 2;
+    WorkerPool::shared().parallel_for(
+        first, last + 1, internal::PARALLEL_NODES,
+        [&](size_t begin, size_t end) {
+          auto hasher = _hasher;
+          for (auto j = begin; j < end; j++) {
+            if (2 * j + 1 < n) {
+              internal::hash_node(hasher, node(level, 2 * j),
+                                  node(level, 2 * j + 1), node(level + 1, j));
+            } else {
+              memcpy(node(level + 1, j), node(level, 2 * j), _digest_len);
+            }
+          }
+        });
+  }
+}
+
+optional<MerkleProof> MerkleTree::prove(size_t index) const {
+  if (index >= size()) return {};
+  MerkleProof proof{_hasher.hash_func(), index, size(), {}};
+  for (size_t level = 0, i = index; level_size(level) > 1; level++, i /= 2) {
+    if ((i ^ 1) >= level_size(level)) continue;
+    auto sibling = &_levels[level][(i ^ 1) * _digest_len];
+    proof.siblings.insert(proof.siblings.end(), sibling,
+                          sibling + _digest_len);
+  }
+  return proof;
+}
+
+}  // namespace multi::hash
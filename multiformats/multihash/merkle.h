@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "multiformats/multihash/multihash.h"
+#include "multiformats/util/common.h"
+
+namespace multi::hash {
+
+using namespace std;
+
+/*
+Inclusion proof for a single leaf of a MerkleTree: the sibling
+digests on the path from the leaf to the root, packed back to back.
+*/
+struct MerkleProof {
+  HFuncCode       func;
+  size_t          index;
+  size_t          leaves;
+  vector<uint8_t> siblings;
+
+  /*
+  Return true if leaf is the index-th leaf of a tree of the given
+  number of leaves whose root is root.
+  */
+  bool verify(const Hash& leaf, const Hash& root) const;
+};
+
+/*
+Merkle tree over a sequence of multihashes, using a single hash
+function for every node.
+
+Leaves are hashed as H(0x00 || raw_sum), inner nodes as
+H(0x01 || left || right), so a leaf can never be passed off as an
+inner node. When a level has an odd number of nodes the last one is
+carried up unchanged.
+
+Each level is stored as one flat array of digests. Appending or
+updating a leaf only rehashes the path from that leaf to the root.
+Wide levels are hashed across several threads.
+*/
+class MerkleTree {
+ public:
+  /*
+  Construct an empty tree using the hash function passed as argument.
+  Returns an empty std::optional if the function is unknown.
+  */
+  static optional<MerkleTree> New(HFuncCode func);
+  /*
+  Construct a tree over leaves, using the hash function passed as
+  argument. Returns an empty std::optional if the function is unknown.
+  */
+  static optional<MerkleTree> New(HFuncCode func, const vector<Hash>& leaves);
+
+  /*
+  Return the number of leaves in the tree.
+  */
+  size_t size() const;
+  /*
+  Return the root of the tree, or an empty std::optional if the
+  tree has no leaves.
+  */
+  optional<Hash> root() const;
+
+  /*
+  Add a leaf at the end of the tree.
+  */
+  void append(const Hash& leaf);
+  /*
+  Add several leaves at the end of the tree, hashing each level once.
+  */
+  void append(const vector<Hash>& leaves);
+  /*
+  Replace the leaf at index. Returns false if index is out of range.
+  */
+  bool update(size_t index, const Hash& leaf);
+
+  /*
+  Return the inclusion proof for the leaf at index, or an empty
+  std::optional if index is out of range.
+  */
+  optional<MerkleProof> prove(size_t index) const;
+
+ private:
+  MerkleTree(const Hasher& hasher);
+
+  size_t   level_size(size_t level) const;
+  uint8_t* node(size_t level, size_t i);
+  // recompute the ancestors of leaves first..last
+  void rehash(size_t first, size_t last);
+
+  // never written to, copied once per range of nodes to hash
+  Hasher                  _hasher;
+  size_t                  _digest_len;
+  vector<vector<uint8_t>> _levels;
+};
+
+}  // namespace multi::hash
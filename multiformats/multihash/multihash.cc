@@ -161,7 +161,7 @@ void Hash::set_hasher(HFuncCode func) {
 }
 
 optional<HFuncCode> check_and_init(const string& hfunc) {
-  if (!Hash::initialized) internal::_init();
+  internal::init();
   if (auto it = internal::code_map.find(hfunc);
       it != internal::code_map.end()) {
     return it->second;
@@ -195,8 +195,145 @@ bool operator==(const Hash& lhs, const Hash& rhs) {
   return lhs._sum == rhs._sum;
 }
 
+optional<Hasher> Hasher::New(HFuncCode func) {
+  internal::init();
+  if (is_blake2b(func) || is_blake2s(func)) return Hasher(func);
+  switch (func) {
+    case HFuncCode::SHA1:
+    case HFuncCode::SHA2_256:
+    case HFuncCode::DBL_SHA2_256:
+    case HFuncCode::SHA2_512:
+    case HFuncCode::SHA3_224:
+    case HFuncCode::SHA3_256:
+    case HFuncCode::SHA3_384:
+    case HFuncCode::SHA3_512:
+      return Hasher(func);
+    default:
+      // registered, but not computed by Hash::sum() either
+      return {};
+  }
+}
+
+Hasher::Hasher(HFuncCode func) :
+    _hfunc(func),
+    _digest_len(internal::default_lengths[func]) {
+  if (is_blake2b(func)) {
+    _state = blake2b_state();
+    blake2b_init(&get<blake2b_state>(_state), _digest_len);
+    return;
+  } else if (is_blake2s(func)) {
+    _state = blake2s_state();
+    blake2s_init(&get<blake2s_state>(_state), _digest_len);
+    return;
+  }
+  switch (func) {
+    case HFuncCode::SHA1:
+      _state = CSHA1();
+      break;
+    case HFuncCode::SHA2_256:
+    case HFuncCode::DBL_SHA2_256:
+      _state = CSHA256();
+      break;
+    case HFuncCode::SHA2_512:
+      _state = CSHA512();
+      break;
+    default:
+      // SHA3 has no streaming implementation, digested in finalize()
+      break;
+  }
+}
+
+Hasher& Hasher::write(const uint8_t* data, size_t len) {
+  if (auto s = get_if<CSHA1>(&_state)) {
+    s->Write(data, len);
+  } else if (auto s = get_if<CSHA256>(&_state)) {
+    s->Write(data, len);
+  } else if (auto s = get_if<CSHA512>(&_state)) {
+    s->Write(data, len);
+  } else if (auto s = get_if<blake2b_state>(&_state)) {
+    blake2b_update(s, data, len);
+  } else if (auto s = get_if<blake2s_state>(&_state)) {
+    blake2s_update(s, data, len);
+  } else {
+    _buffered.append((const char*)data, len);
+  }
+  return *this;
+}
+
+Hasher& Hasher::reset() {
+  if (auto s = get_if<CSHA1>(&_state)) {
+    s->Reset();
+  } else if (auto s = get_if<CSHA256>(&_state)) {
+    s->Reset();
+  } else if (auto s = get_if<CSHA512>(&_state)) {
+    s->Reset();
+  } else if (auto s = get_if<blake2b_state>(&_state)) {
+    blake2b_init(s, _digest_len);
+  } else if (auto s = get_if<blake2s_state>(&_state)) {
+    blake2s_init(s, _digest_len);
+  }
+  _buffered.clear();
+  return *this;
+}
+
+Hash Hasher::finalize() {
+  auto code   = static_cast<underlying_type_t<HFuncCode>>(_hfunc);
+  auto prefix = varint::encode(code);
+  auto c_len  = prefix.size();
+  auto size   = varint::encode(_digest_len);
+  auto l_len  = size.size();
+
+  vector<uint8_t> raw_sum(prefix);
+  raw_sum.insert(raw_sum.end(), size.begin(), size.end());
+  raw_sum.resize(c_len + l_len + _digest_len);
+  finalize(&raw_sum[c_len + l_len]);
+  return Hash(code, c_len, _digest_len, l_len, raw_sum);
+}
+
+void Hasher::finalize(uint8_t* out) {
+  if (auto s = get_if<CSHA1>(&_state)) {
+    s->Finalize(out);
+  } else if (auto s = get_if<CSHA256>(&_state)) {
+    s->Finalize(out);
+    if (_hfunc == HFuncCode::DBL_SHA2_256) {
+      s->Reset().Write(out, _digest_len).Finalize(out);
+    }
+  } else if (auto s = get_if<CSHA512>(&_state)) {
+    s->Finalize(out);
+  } else if (auto s = get_if<blake2b_state>(&_state)) {
+    blake2b_final(s, out, _digest_len);
+  } else if (auto s = get_if<blake2s_state>(&_state)) {
+    blake2s_final(s, out, _digest_len);
+  } else {
+    auto data = (const uint8_t*)_buffered.data();
+    auto len  = _buffered.size();
+    switch (_hfunc) {
+      case HFuncCode::SHA3_224:
+        sha3_224(out, _digest_len, data, len);
+        break;
+      case HFuncCode::SHA3_256:
+        sha3_256(out, _digest_len, data, len);
+        break;
+      case HFuncCode::SHA3_384:
+        sha3_384(out, _digest_len, data, len);
+        break;
+      case HFuncCode::SHA3_512:
+        sha3_512(out, _digest_len, data, len);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
 namespace internal {
 
+void init() {
+  // Hasher::New() may first run on several hash_file_async() workers
+  static once_flag once;
+  call_once(once, _init);
+}
+
 void _init() {
   // generate all the blake2b names
   auto min = static_cast<underlying_type_t<HFuncCode>>(HFuncCode::BLAKE2B_MIN);
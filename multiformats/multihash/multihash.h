@@ -5,7 +5,9 @@
 #include <cstdint>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <string>
+#include <variant>
 #include <vector>
 
 #include "multiformats/util/common.h"
@@ -113,6 +115,13 @@ class Hash {
   */
   vector<uint8_t> raw_sum() const;
   /*
+  Same as raw_sum(), without copying the bytes. The reference is
+  valid as long as this Hash object is alive and not modified.
+  */
+  const vector<uint8_t>& raw_sum_ref() const {
+    return _sum;
+  }
+  /*
   return hex encoded strong for the code prefix
   */
   string prefix_hex() const;
@@ -129,6 +138,7 @@ class Hash {
   inline static bool initialized = false;
 
   friend bool operator==(const Hash& lhs, const Hash& rhs);
+  friend class Hasher;
 
  private:
   Hash() = delete;
@@ -158,6 +168,62 @@ class Hash {
 // compare if two Hash objects have equal raw sums
 bool operator==(const Hash& lhs, const Hash& rhs);
 
+/*
+Hasher computes a multihash incrementally, for input that arrives
+in pieces (e.g. a file read chunk by chunk) and would otherwise have
+to be joined into a single string before calling Hash::sum().
+
+SHA1, SHA2 and BLAKE2 are digested as data is written. SHA3 has no
+streaming implementation, so its input is buffered in memory and
+digested in finalize(), which yields the same sum as Hash::sum().
+*/
+class Hasher {
+ public:
+  /*
+  Construct a new Hasher for the hash function passed as argument.
+  Returns an empty std::optional if the function is unknown or has
+  no implementation (KECCAK, SHAKE and MURMUR3).
+  */
+  static optional<Hasher> New(HFuncCode func);
+
+  /*
+  Feed the next len bytes of input to the hasher.
+  */
+  Hasher& write(const uint8_t* data, size_t len);
+  /*
+  Discard the input written so far, so the same Hasher can digest
+  another one. Memory already buffered for SHA3 is kept for reuse.
+  */
+  Hasher& reset();
+  /*
+  Finish the digest and return it as a Hash object. The Hasher
+  must not be written to after finalize() has been called, unless
+  it is reset() first.
+  */
+  Hash finalize();
+  /*
+  Finish the digest and write its digest_len() bytes to out,
+  without the multihash prefix.
+  */
+  void finalize(uint8_t* out);
+
+  HFuncCode hash_func() const {
+    return _hfunc;
+  }
+  size_t digest_len() const {
+    return _digest_len;
+  }
+
+ private:
+  Hasher(HFuncCode func);
+
+  HFuncCode _hfunc;
+  size_t    _digest_len;
+  variant<monostate, CSHA1, CSHA256, CSHA512, blake2b_state, blake2s_state>
+         _state;
+  string _buffered;
+};
+
 /*
 Return a new Hash object. If not provided any arguments,
 it will default to using SHA-256 as its hashing function.
@@ -202,6 +268,8 @@ constexpr bool is_blake2s(HFuncCode c) {
 
 namespace internal {
 
+// fill in the BLAKE2 entries of the tables below, once per process
+void init();
 void _init();
 
 void sum_sha1(CSHA1* hasher, const string& data, vector<uint8_t>& out,
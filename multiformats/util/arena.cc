@@ -0,0 +1,50 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace multi {
+
+static uint8_t* align_up(uint8_t* p, size_t align) {
+  return (uint8_t*)(((uintptr_t)p + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+Arena::Arena(size_t block_size) : _block_size(block_size) {}
+
+Arena::Arena(Arena&& other) :
+    _block_size(other._block_size),
+    _reserved(std::exchange(other._reserved, 0)),
+    _curr(std::exchange(other._curr, nullptr)),
+    _end(std::exchange(other._end, nullptr)),
+    _blocks(std::move(other._blocks)) {
+  other._blocks.clear();
+}
+
+Arena& Arena::operator=(Arena&& other) {
+  if (this != &other) {
+    _block_size = other._block_size;
+    _reserved   = std::exchange(other._reserved, 0);
+    _curr       = std::exchange(other._curr, nullptr);
+    _end        = std::exchange(other._end, nullptr);
+    _blocks     = std::move(other._blocks);
+    other._blocks.clear();
+  }
+  return *this;
+}
+
+void* Arena::allocate(size_t size, size_t align) {
+  auto p = align_up(_curr, align);
+  if (_curr == nullptr || p + size > _end) {
+    // oversized requests get a block of their own
+    auto n = std::max(_block_size, size + align);
+    _blocks.emplace_back(new uint8_t[n]);
+    _reserved += n;
+    _curr = _blocks.back().get();
+    _end  = _curr + n;
+    p     = align_up(_curr, align);
+  }
+  _curr = p + size;
+  return p;
+}
+
+}  // namespace multi
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace multi {
+
+/*
+Bump allocator handing out memory from large blocks. Individual
+allocations are never freed; everything is released at once when
+the Arena is destroyed. Only meant for trivially destructible types.
+*/
+class Arena {
+ public:
+  explicit Arena(size_t block_size = 1 << 16);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  // the moved-from arena is left empty and allocates fresh blocks
+  Arena(Arena&& other);
+  Arena& operator=(Arena&& other);
+
+  /*
+  Return size bytes of uninitialized memory, aligned to align
+  (which must be a power of two).
+  */
+  void* allocate(size_t size, size_t align = alignof(max_align_t));
+
+  /*
+  Return uninitialized storage for n objects of type T.
+  */
+  template <typename T>
+  T* allocate(size_t n) {
+    return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+  }
+
+  /*
+  Total number of bytes reserved from the system so far.
+  */
+  size_t reserved() const {
+    return _reserved;
+  }
+
+ private:
+  size_t                                  _block_size;
+  size_t                                  _reserved = 0;
+  uint8_t*                                _curr     = nullptr;
+  uint8_t*                                _end      = nullptr;
+  std::vector<std::unique_ptr<uint8_t[]>> _blocks;
+};
+
+}  // namespace multi
@@ -0,0 +1,47 @@
+#include "worker_pool.h"
+
+namespace multi {
+
+WorkerPool::WorkerPool(size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    _workers.emplace_back([this] { run(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mu);
+    _stop = true;
+  }
+  _cv.notify_all();
+  for (auto& w : _workers) w.join();
+}
+
+WorkerPool& WorkerPool::shared() {
+  static WorkerPool pool(std::max(2u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+void WorkerPool::push(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(_mu);
+    _jobs.push(std::move(job));
+  }
+  _cv.notify_one();
+}
+
+void WorkerPool::run() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(_mu);
+      _cv.wait(lock, [this] { return _stop || !_jobs.empty(); });
+      if (_jobs.empty()) return;
+      job = std::move(_jobs.front());
+      _jobs.pop();
+    }
+    job();
+  }
+}
+
+}  // namespace multi
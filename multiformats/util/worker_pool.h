@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace multi {
+
+/*
+Fixed set of worker threads consuming a shared job queue. Pending
+jobs are still run when the pool is destroyed.
+*/
+class WorkerPool {
+ public:
+  explicit WorkerPool(size_t n);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /*
+  Return the process wide pool, with one thread per core (and at
+  least two), started on first use.
+  */
+  static WorkerPool& shared();
+
+  /*
+  Queue a job to be run on one of the worker threads.
+  */
+  void push(std::function<void()> job);
+
+  /*
+  Split [first, last) into ranges of at least grain indices and call
+  f(begin, end) for each of them, spread over the workers. The calling
+  thread works on ranges as well and only waits for ranges already
+  being run, so this can be called from a job running on the pool.
+  */
+  template <typename F>
+  void parallel_for(size_t first, size_t last, size_t grain, F f);
+
+ private:
+  void run();
+
+  std::mutex                        _mu;
+  std::condition_variable           _cv;
+  std::queue<std::function<void()>> _jobs;
+  std::vector<std::thread>          _workers;
+  bool                              _stop = false;
+};
+
+template <typename F>
+void WorkerPool::parallel_for(size_t first, size_t last, size_t grain, F f) {
+  size_t n      = last > first ? last - first : 0;
+  size_t chunks = std::min(_workers.size() + 1, n / std::max<size_t>(grain, 1));
+  if (chunks < 2) {
+    if (n > 0) f(first, last);
+    return;
+  }
+
+  // shared with helper jobs, which may only start after we returned
+  struct State {
+    std::atomic<size_t>     next{0};
+    size_t                  done = 0;
+    std::mutex              mu;
+    std::condition_variable cv;
+  };
+  auto   state = std::make_shared<State>();
+  size_t step  = (n + chunks - 1) / chunks;
+
+  auto work = [=] {
+    for (size_t c; (c = state->next++) < chunks;) {
+      auto begin = std::min(first + c * step, last);
+      auto end   = std::min(begin + step, last);
+      if (begin < end) f(begin, end);
+      std::lock_guard<std::mutex> lock(state->mu);
+      if (++state->done == chunks) state->cv.notify_all();
+    }
+  };
+  for (size_t i = 1; i < chunks; i++) push(work);
+  work();
+
+  std::unique_lock<std::mutex> lock(state->mu);
+  state->cv.wait(lock, [&] { return state->done == chunks; });
+}
+
+}  // namespace multi
@@ -0,0 +1,80 @@
+#include "multiformats/multihash/hash_columns.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+namespace mh = multi::hash;
+
+namespace {
+
+vector<mh::Hash> test_hashes() {
+  vector<mh::Hash> hashes;
+  for (auto name : {"sha1", "sha2-256", "sha2-512", "sha3-224",
+                    "blake2b-256", "blake2s-128", "sha2-256"}) {
+    hashes.push_back(*mh::New("data for "s + name, name));
+  }
+  return hashes;
+}
+
+vector<uint8_t> concat(const vector<mh::Hash>& hashes) {
+  vector<uint8_t> out;
+  for (auto& h : hashes) {
+    auto raw = h.raw_sum();
+    out.insert(out.end(), raw.begin(), raw.end());
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(HashColumnsTest, DecodeAll) {
+  auto         hashes = test_hashes();
+  multi::Arena arena;
+  auto         cols = mh::DecodeAll(concat(hashes), arena);
+  ASSERT_TRUE(cols);
+  ASSERT_EQ(cols->size(), hashes.size());
+  for (size_t i = 0; i < hashes.size(); i++) {
+    auto h = mh::Decode(hashes[i].raw_sum());
+    ASSERT_TRUE(h);
+    EXPECT_EQ(cols->code(i), mh::check_and_init(h->hash_func_name()));
+    EXPECT_EQ(HexStr(cols->digest(i), cols->digest(i) + cols->digest_len(i)),
+              h->digest_hex());
+  }
+  EXPECT_EQ(cols->offsets()[0], 0u);
+  EXPECT_EQ(cols->digests() + cols->offsets()[cols->size()],
+            cols->digest(cols->size() - 1) +
+                cols->digest_len(cols->size() - 1));
+}
+
+TEST(HashColumnsTest, Empty) {
+  multi::Arena arena;
+  auto         cols = mh::DecodeAll({}, arena);
+  ASSERT_TRUE(cols);
+  EXPECT_TRUE(cols->empty());
+}
+
+TEST(HashColumnsTest, Invalid) {
+  multi::Arena arena;
+  auto         raw = concat(test_hashes());
+  // truncated last entry
+  EXPECT_FALSE(mh::DecodeAll({raw.begin(), raw.end() - 1}, arena));
+  // unknown hash function
+  auto bad = raw;
+  bad[0]   = 0x01;
+  EXPECT_FALSE(mh::DecodeAll(bad, arena));
+  // wrong digest length
+  bad    = raw;
+  bad[1] = 0x10;
+  EXPECT_FALSE(mh::DecodeAll(bad, arena));
+}
+
+TEST(HashColumnsTest, ArenaMove) {
+  multi::Arena x;
+  auto         a = x.allocate<uint64_t>(1);
+  multi::Arena y(move(x));
+  EXPECT_EQ(x.reserved(), 0u);
+  // the moved-from arena must not hand out memory from y's block
+  auto b = x.allocate<uint64_t>(1);
+  auto c = y.allocate<uint64_t>(1);
+  EXPECT_NE(b, a + 1);
+  EXPECT_EQ(c, a + 1);
+}
@@ -0,0 +1,124 @@
+#include "multiformats/multihash/hash_file.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <future>
+
+using namespace std;
+namespace mh = multi::hash;
+
+namespace {
+
+string write_temp_file(const string& data) {
+  char path[] = "/tmp/hash_file_testXXXXXX";
+  close(mkstemp(path));
+  ofstream(path, ios::binary) << data;
+  return path;
+}
+
+// spans several read chunks and ends with a partial one
+string test_data() {
+  string data;
+  for (size_t i = 0; data.size() < (1 << 20) + 123; i++) {
+    data += "this is some data to hash " + to_string(i) + "\n";
+  }
+  return data;
+}
+
+// io_uring is only checked where the kernel lets us use it
+vector<mh::FileIO> backends() {
+  if (mh::io_uring_available()) {
+    return {mh::FileIO::IO_URING, mh::FileIO::PREAD};
+  }
+  return {mh::FileIO::PREAD};
+}
+
+}  // namespace
+
+// keep first: hash functions must not have been looked up yet
+TEST(HashFileTest, AsyncBeforeInit) {
+  auto path = write_temp_file(test_data());
+
+  vector<promise<optional<mh::Hash>>> results(8);
+  for (size_t i = 0; i < results.size(); i++) {
+    mh::hash_file_async(path, mh::HFuncCode{0xb220},
+                        [&, i](auto h) { results[i].set_value(h); });
+  }
+  auto expected = mh::New(test_data(), "blake2b-256");
+  for (auto& r : results) {
+    auto h = r.get_future().get();
+    ASSERT_TRUE(h);
+    EXPECT_EQ(h->hex(), expected->hex());
+  }
+  remove(path.c_str());
+}
+
+TEST(HashFileTest, MatchesSum) {
+  auto data = test_data();
+  auto path = write_temp_file(data);
+  for (auto name : {"sha1", "sha2-256", "sha2-512", "dbl-sha2-256",
+                    "blake2b-256", "blake2s-128", "sha3-256"}) {
+    auto expected = mh::New(data, name);
+    ASSERT_TRUE(expected) << name;
+    auto func = mh::check_and_init(name);
+    for (auto io : backends()) {
+      auto h = mh::hash_file(path, *func, io);
+      ASSERT_TRUE(h) << name;
+      EXPECT_EQ(h->hex(), expected->hex()) << name;
+    }
+  }
+  remove(path.c_str());
+}
+
+TEST(HashFileTest, EmptyFile) {
+  auto path     = write_temp_file("");
+  auto expected = mh::New("", "sha2-256");
+  for (auto io : backends()) {
+    auto h = mh::hash_file(path, mh::HFuncCode::SHA2_256, io);
+    ASSERT_TRUE(h);
+    EXPECT_EQ(h->hex(), expected->hex());
+  }
+  remove(path.c_str());
+}
+
+TEST(HashFileTest, MissingFile) {
+  EXPECT_FALSE(mh::hash_file("/nonexistent/file", mh::HFuncCode::SHA2_256));
+}
+
+TEST(HashFileTest, IoUringNoFallback) {
+  // not a regular file, so only the pread path can hash it
+  EXPECT_FALSE(mh::hash_file("/dev/null", mh::HFuncCode::SHA2_256,
+                             mh::FileIO::IO_URING));
+  EXPECT_TRUE(mh::hash_file("/dev/null", mh::HFuncCode::SHA2_256));
+}
+
+TEST(HashFileTest, UnsupportedFunction) {
+  auto path = write_temp_file("this is some data to hash");
+  for (auto func : {mh::HFuncCode::KECCAK_256, mh::HFuncCode::SHAKE_128,
+                    mh::HFuncCode::MURMUR3_32}) {
+    EXPECT_FALSE(mh::Hasher::New(func));
+    EXPECT_FALSE(mh::hash_file(path, func));
+  }
+  remove(path.c_str());
+}
+
+TEST(HashFileTest, Async) {
+  auto data     = test_data();
+  auto path     = write_temp_file(data);
+  auto expected = mh::New(data, "sha2-256");
+
+  auto                                io = backends();
+  vector<promise<optional<mh::Hash>>> results(8);
+  for (size_t i = 0; i < results.size(); i++) {
+    mh::hash_file_async(path, mh::HFuncCode::SHA2_256,
+                        [&, i](auto h) { results[i].set_value(h); },
+                        io[i % io.size()]);
+  }
+  for (auto& r : results) {
+    auto h = r.get_future().get();
+    ASSERT_TRUE(h);
+    EXPECT_EQ(h->hex(), expected->hex());
+  }
+  remove(path.c_str());
+}
@@ -0,0 +1,131 @@
+#include "multiformats/multihash/merkle.h"
+#include "gtest/gtest.h"
+
+#include <future>
+
+#include "multiformats/util/worker_pool.h"
+
+using namespace std;
+namespace mh = multi::hash;
+
+namespace {
+
+vector<mh::Hash> test_leaves(size_t n, const string& salt = "") {
+  vector<mh::Hash> leaves;
+  for (size_t i = 0; i < n; i++) {
+    leaves.push_back(*mh::New(salt + "block " + to_string(i), "sha2-256"));
+  }
+  return leaves;
+}
+
+}  // namespace
+
+TEST(MerkleTest, Empty) {
+  auto tree = mh::MerkleTree::New(mh::HFuncCode::SHA2_256);
+  ASSERT_TRUE(tree);
+  EXPECT_EQ(tree->size(), 0u);
+  EXPECT_FALSE(tree->root());
+  EXPECT_FALSE(tree->prove(0));
+}
+
+TEST(MerkleTest, UnsupportedFunction) {
+  // registered, but without an implementation to hash nodes with
+  EXPECT_FALSE(mh::MerkleTree::New(mh::HFuncCode::KECCAK_256));
+  EXPECT_FALSE(mh::MerkleTree::New(mh::HFuncCode::MURMUR3_32));
+
+  auto leaves = test_leaves(2);
+  auto tree   = mh::MerkleTree::New(mh::HFuncCode::SHA2_256, leaves);
+  auto proof  = *tree->prove(0);
+  proof.func  = mh::HFuncCode::KECCAK_256;
+  EXPECT_FALSE(proof.verify(leaves[0], *tree->root()));
+}
+
+TEST(MerkleTest, KnownRoot) {
+  auto leaf = [](const mh::Hash& h) {
+    auto raw = h.raw_sum();
+    return "\x00"s + string(raw.begin(), raw.end());
+  };
+  auto node = [](const mh::Hash& l, const mh::Hash& r) {
+    auto lraw = l.raw_sum();
+    auto rraw = r.raw_sum();
+    return "\x01"s + string(lraw.end() - 32, lraw.end()) +
+           string(rraw.end() - 32, rraw.end());
+  };
+  // 32 byte digests, computed without reusing a Hasher
+  for (auto name : {"sha2-256", "sha3-256", "blake2b-256"}) {
+    auto leaves = test_leaves(3);
+    auto tree   = mh::MerkleTree::New(*mh::check_and_init(name), leaves);
+    ASSERT_TRUE(tree);
+
+    auto h0 = *mh::New(leaf(leaves[0]), name);
+    auto h1 = *mh::New(leaf(leaves[1]), name);
+    auto h2 = *mh::New(leaf(leaves[2]), name);
+    // the third leaf has no sibling and is carried up as is
+    auto root = *mh::New(node(*mh::New(node(h0, h1), name), h2), name);
+    EXPECT_EQ(tree->root()->hex(), root.hex()) << name;
+  }
+}
+
+TEST(MerkleTest, IncrementalMatchesBatch) {
+  for (auto func : {mh::HFuncCode::SHA2_256, mh::HFuncCode::SHA3_256,
+                    mh::HFuncCode{0xb220}}) {
+    for (size_t n : {1, 2, 5, 8, 13, 100}) {
+      auto leaves = test_leaves(n);
+      auto batch  = mh::MerkleTree::New(func, leaves);
+      auto incr   = mh::MerkleTree::New(func);
+      ASSERT_TRUE(batch && incr);
+      for (auto& l : leaves) incr->append(l);
+      EXPECT_EQ(batch->root()->hex(), incr->root()->hex()) << n;
+    }
+  }
+}
+
+TEST(MerkleTest, Update) {
+  auto leaves   = test_leaves(37);
+  auto replaced = test_leaves(37, "new ");
+  auto tree     = mh::MerkleTree::New(mh::HFuncCode::SHA2_256, leaves);
+  for (size_t i : {0, 17, 36}) {
+    auto old_root = *tree->root();
+    ASSERT_TRUE(tree->update(i, replaced[i]));
+    leaves[i] = replaced[i];
+    EXPECT_NE(tree->root()->hex(), old_root.hex());
+    auto rebuilt = mh::MerkleTree::New(mh::HFuncCode::SHA2_256, leaves);
+    EXPECT_EQ(tree->root()->hex(), rebuilt->root()->hex()) << i;
+  }
+  EXPECT_FALSE(tree->update(37, replaced[0]));
+}
+
+TEST(MerkleTest, Proofs) {
+  auto leaves = test_leaves(11);
+  auto tree   = mh::MerkleTree::New(mh::HFuncCode::SHA2_512, leaves);
+  auto root   = *tree->root();
+  for (size_t i = 0; i < leaves.size(); i++) {
+    auto proof = tree->prove(i);
+    ASSERT_TRUE(proof);
+    EXPECT_TRUE(proof->verify(leaves[i], root)) << i;
+    EXPECT_FALSE(proof->verify(leaves[(i + 1) % leaves.size()], root)) << i;
+  }
+  auto proof = *tree->prove(3);
+  proof.siblings[0] ^= 1;
+  EXPECT_FALSE(proof.verify(leaves[3], root));
+}
+
+TEST(MerkleTest, WideLevels) {
+  // enough leaves for the bottom levels to be hashed on several threads
+  auto leaves = test_leaves(20000);
+  auto batch  = mh::MerkleTree::New(mh::HFuncCode::SHA2_256, leaves);
+  auto incr   = mh::MerkleTree::New(mh::HFuncCode::SHA2_256);
+  incr->append(vector<mh::Hash>(leaves.begin(), leaves.begin() + 12345));
+  incr->append(vector<mh::Hash>(leaves.begin() + 12345, leaves.end()));
+  EXPECT_EQ(batch->root()->hex(), incr->root()->hex());
+  EXPECT_TRUE(batch->prove(19999)->verify(leaves[19999], *batch->root()));
+
+  // wide levels hashed from inside a job already running on the pool
+  promise<string> root;
+  multi::WorkerPool::shared().push([&] {
+    root.set_value(mh::MerkleTree::New(mh::HFuncCode::SHA2_256, leaves)
+                       ->root()
+                       ->hex());
+  });
+  EXPECT_EQ(root.get_future().get(), batch->root()->hex());
+}